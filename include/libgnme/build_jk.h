@@ -0,0 +1,71 @@
+#ifndef LIBGNME_BUILD_JK_H
+#define LIBGNME_BUILD_JK_H
+
+#include <armadillo>
+#include "eri_screen.h"
+
+namespace libgnme {
+
+/** \brief Build Coulomb and exchange matrices for a set of (co-)density matrices
+           in a single pass over the two-electron integrals.
+
+    For each density D, the Coulomb and exchange matrices are defined as
+        J(s,t) = sum_{mn} (mn|st) D(n,m)
+        K(s,t) = sum_{mn} (mt|sn) D(n,m)
+    The densities do not need to be symmetric or real.
+
+    \param D Field containing the (co-)density matrices in AO basis
+    \param IIao Two-electron integrals in AO basis with chemists indexing,
+                e.g. (ij|kl) = IIao(i*nbsf+j,k*nbsf+l)
+    \param[out] J Field containing Coulomb matrix for each density
+    \param[out] K Field containing exchange matrix for each density
+    \ingroup gnme_utils
+ **/
+template<typename Tc, typename Tb>
+void build_jk(
+    const arma::field<arma::Mat<Tc> > &D, const arma::Mat<Tb> &IIao,
+    arma::field<arma::Mat<Tc> > &J, arma::field<arma::Mat<Tc> > &K);
+
+/** \brief Build Coulomb and exchange matrices for a set of (co-)density matrices
+           with density-weighted Schwarz screening.
+
+    Bra pairs [mn] are skipped in the Coulomb matrices when Q(m,n) max(Q) |D(n,m)| is
+    below the threshold, and Coulomb elements J(s,t) are skipped when Q(s,t) times the
+    Schwarz-weighted norm of the density is below the threshold. For the exchange 
+    matrices, pairs (s,n) are skipped when Q(s,n) max(Q) sum_m |D(n,m)| is below the 
+    threshold. Only the retained integrals are read.
+
+    \param D Field containing the (co-)density matrices in AO basis
+    \param IIao Two-electron integrals in AO basis with chemists indexing,
+                e.g. (ij|kl) = IIao(i*nbsf+j,k*nbsf+l)
+    \param screen Schwarz factors and threshold for the integrals
+    \param[out] J Field containing Coulomb matrix for each density
+    \param[out] K Field containing exchange matrix for each density
+    \param[out] err Upper bound on the neglected contribution to any element of J or K
+    \ingroup gnme_utils
+ **/
+template<typename Tc, typename Tb>
+void build_jk(
+    const arma::field<arma::Mat<Tc> > &D, const arma::Mat<Tb> &IIao, const eri_screen &screen,
+    arma::field<arma::Mat<Tc> > &J, arma::field<arma::Mat<Tc> > &K, double &err);
+
+/** \brief Build Coulomb and exchange matrices for a set of (co-)density matrices
+           from three-index factorised two-electron integrals.
+
+    The two-electron integrals are represented by Cholesky or density-fitting factors
+    with (mn|st) = sum_P L(m,n,P) L(s,t,P), so the four-index tensor is never formed.
+
+    \param D Field containing the (co-)density matrices in AO basis
+    \param L Cube containing the three-index factors L(m,n,P)
+    \param[out] J Field containing Coulomb matrix for each density
+    \param[out] K Field containing exchange matrix for each density
+    \ingroup gnme_utils
+ **/
+template<typename Tc, typename Tb>
+void build_jk(
+    const arma::field<arma::Mat<Tc> > &D, const arma::Cube<Tb> &L,
+    arma::field<arma::Mat<Tc> > &J, arma::field<arma::Mat<Tc> > &K);
+
+} // namespace libgnme
+
+#endif // LIBGNME_BUILD_JK_H
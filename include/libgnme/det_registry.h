@@ -0,0 +1,70 @@
+#ifndef LIBGNME_DET_REGISTRY_H
+#define LIBGNME_DET_REGISTRY_H
+
+#include <vector>
+#include <armadillo>
+
+namespace libgnme {
+
+/** \brief Registry of reference determinants with cached per-determinant intermediates
+
+    Each determinant is stored with its orbital coefficients C and the metric-transformed
+    coefficients S*C, which are computed once when the determinant is added. These are
+    shared by every pair that the determinant takes part in, leaving only the
+    pair-dependent work for the pair setup.
+
+    \tparam Tc Type defining orbital coefficients
+    \tparam Tb Type defining basis functions
+    \ingroup gnme_utils
+ **/
+template<typename Tc, typename Tb>
+class det_registry
+{
+private:
+    const arma::Mat<Tb> &m_metric; //!< Basis overlap metric
+    std::vector<arma::Mat<Tc> > m_C; //!< Orbital coefficients
+    std::vector<arma::Mat<Tc> > m_SC; //!< Metric-transformed orbital coefficients
+
+public:
+    /** \brief Constructor for the object
+        \param metric Overlap matrix of the basis functions
+     **/
+    det_registry(const arma::Mat<Tb> &metric) : m_metric(metric)
+    { }
+
+    /** \brief Constructor for the object from a set of determinants
+        \param metric Overlap matrix of the basis functions
+        \param C Cube containing the orbital coefficients of each determinant
+     **/
+    det_registry(const arma::Mat<Tb> &metric, const arma::Cube<Tc> &C) : m_metric(metric)
+    {
+        add(C);
+    }
+
+    /** \brief Destructor **/
+    virtual ~det_registry() { }
+
+    /** \brief Add a determinant to the registry
+        \param C Orbital coefficients of the determinant
+        \return Index of the determinant in the registry
+     **/
+    size_t add(const arma::Mat<Tc> &C);
+
+    /** \brief Add a set of determinants to the registry
+        \param C Cube containing the orbital coefficients of each determinant
+     **/
+    void add(const arma::Cube<Tc> &C);
+
+    /** \brief Number of determinants in the registry **/
+    size_t size() const { return m_C.size(); }
+
+    /** \brief Orbital coefficients of determinant i **/
+    const arma::Mat<Tc> &C(size_t i) const { return m_C.at(i); }
+
+    /** \brief Metric-transformed orbital coefficients of determinant i **/
+    const arma::Mat<Tc> &SC(size_t i) const { return m_SC.at(i); }
+};
+
+} // namespace libgnme
+
+#endif // LIBGNME_DET_REGISTRY_H
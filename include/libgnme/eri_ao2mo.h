@@ -1,10 +1,18 @@
 #ifndef LIBGNME_ERI_AO2MO_H
 #define LIBGNME_ERI_AO2MO_H
 
-#include <armadillo> 
+#include <armadillo>
+#include "eri_screen.h"
 
 namespace libgnme {
 
+/** \brief Antisymmetrise MO integrals in place as (12|34) - (14|32)
+    \param IImo Matrix representation of two-electron integrals in MO basis
+    \param nmo Number of MOs for each index
+ **/
+template<typename Tc>
+void eri_antisymmetrise(arma::Mat<Tc> &IImo, size_t nmo);
+
 /** \brief Perform two-electron integral transform from AO to MO basis using chemists
            indexing (C1 C2 | C3 C4)
     \param C1 Coefficients of index 1 in AO basis
@@ -17,8 +25,79 @@ namespace libgnme {
  **/
 template<typename Tc, typename Tb>
 void eri_ao2mo(
-    arma::Mat<Tc> &C1, arma::Mat<Tc> &C2, arma::Mat<Tc> &C3, arma::Mat<Tc> &C4, 
-    arma::Mat<Tb> &IIao, arma::Mat<Tc> &IImo, 
+    const arma::Mat<Tc> &C1, const arma::Mat<Tc> &C2, const arma::Mat<Tc> &C3, const arma::Mat<Tc> &C4,
+    const arma::Mat<Tb> &IIao, arma::Mat<Tc> &IImo,
+    size_t nmo, bool antisym);
+
+/** \brief Perform two-electron integral transform from AO to MO basis using chemists
+           indexing (C1 C2 | C3 C4) with caller-provided scratch memory.
+
+    The transform is performed as a sequence of matrix-matrix products over blocks
+    of the first AO index, with the block size chosen so that the scratch memory
+    does not exceed max_mem (unless a single block requires more).
+
+    \param C1 Coefficients of index 1 in AO basis
+    \param C2 Coefficients of index 2 in AO basis
+    \param C3 Coefficients of index 3 in AO basis
+    \param C4 Coefficients of index 4 in AO basis
+    \param IIao Matrix representation of two-electron integrals in AO basis
+    \param IImo Output matrix representation of two-electron integrals in MO basis
+    \param antisym Antisymmetrise the integrals if true
+    \param work Scratch memory, resized only if it is too small
+    \param max_mem Target limit for the scratch memory in MB (default 1024)
+ **/
+template<typename Tc, typename Tb>
+void eri_ao2mo(
+    const arma::Mat<Tc> &C1, const arma::Mat<Tc> &C2, const arma::Mat<Tc> &C3, const arma::Mat<Tc> &C4,
+    const arma::Mat<Tb> &IIao, arma::Mat<Tc> &IImo,
+    size_t nmo, bool antisym, arma::Col<Tc> &work, size_t max_mem=1024);
+
+/** \brief Perform two-electron integral transform from AO to MO basis using chemists
+           indexing (C1 C2 | C3 C4) with coefficient-weighted Schwarz screening.
+
+    Each AO pair [pq] is weighted as w(p,q) = Q(p,q) max_i |C1(p,i)| max_j |C2(q,j)| for 
+    the bra, and similarly for the ket. Bra pairs are skipped when w(p,q) times the sum
+    of the ket weights is below the threshold, and ket pairs likewise. The integrals
+    between the significant pairs are transformed directly in the pair basis, with the
+    memory for each batch of ket pairs limited by max_mem. If too few pairs are skipped
+    to reduce the work, the unscreened transform is used and err is zero.
+
+    \param C1 Coefficients of index 1 in AO basis
+    \param C2 Coefficients of index 2 in AO basis
+    \param C3 Coefficients of index 3 in AO basis
+    \param C4 Coefficients of index 4 in AO basis
+    \param IIao Matrix representation of two-electron integrals in AO basis
+    \param screen Schwarz factors and threshold for the integrals
+    \param IImo Output matrix representation of two-electron integrals in MO basis
+    \param antisym Antisymmetrise the integrals if true
+    \param[out] err Upper bound on the neglected contribution to any MO integral
+    \param work Scratch memory, resized only if it is too small
+    \param max_mem Target limit for the scratch memory in MB (default 1024)
+ **/
+template<typename Tc, typename Tb>
+void eri_ao2mo(
+    const arma::Mat<Tc> &C1, const arma::Mat<Tc> &C2, const arma::Mat<Tc> &C3, const arma::Mat<Tc> &C4,
+    const arma::Mat<Tb> &IIao, const eri_screen &screen, arma::Mat<Tc> &IImo,
+    size_t nmo, bool antisym, double &err, arma::Col<Tc> &work, size_t max_mem=1024);
+
+/** \brief Perform two-electron integral transform from AO to MO basis using chemists
+           indexing (C1 C2 | C3 C4) with three-index factorised integrals.
+
+    The AO integrals are represented by Cholesky or density-fitting factors
+    with (mn|st) = sum_P L(m,n,P) L(s,t,P), and the four-index AO tensor is never formed.
+
+    \param C1 Coefficients of index 1 in AO basis
+    \param C2 Coefficients of index 2 in AO basis
+    \param C3 Coefficients of index 3 in AO basis
+    \param C4 Coefficients of index 4 in AO basis
+    \param L Cube containing the three-index factors L(m,n,P)
+    \param IImo Output matrix representation of two-electron integrals in MO basis
+    \param antisym Antisymmetrise the integrals if true
+ **/
+template<typename Tc, typename Tb>
+void eri_ao2mo(
+    const arma::Mat<Tc> &C1, const arma::Mat<Tc> &C2, const arma::Mat<Tc> &C3, const arma::Mat<Tc> &C4,
+    const arma::Cube<Tb> &L, arma::Mat<Tc> &IImo,
     size_t nmo, bool antisym);
 
 } // namespace libgnme
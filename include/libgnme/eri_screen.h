@@ -0,0 +1,57 @@
+#ifndef LIBGNME_ERI_SCREEN_H
+#define LIBGNME_ERI_SCREEN_H
+
+#include <armadillo>
+
+namespace libgnme {
+
+/** \brief Schwarz screening of the two-electron integrals in the AO basis
+
+    The Schwarz factors Q(m,n) = |(mn|nm)|^{1/2} bound each integral as
+        |(mn|st)| <= Q(m,n) Q(s,t)
+    and are used to skip contributions to the Coulomb, exchange and MO integrals
+    that fall below a threshold once weighted by the densities or orbital coefficients
+    they are contracted with. Routines using the screening report an upper bound on
+    the magnitude of the neglected contributions to each output element.
+
+    Basis functions are treated individually, so each basis function pair takes the
+    role of a shell pair.
+
+    \ingroup gnme_utils
+ **/
+class eri_screen
+{
+private:
+    size_t m_nbsf; //!< Number of basis functions
+    double m_thresh; //!< Screening threshold
+    double m_Qmax; //!< Largest Schwarz factor
+    arma::vec m_Q; //!< Schwarz factors Q(m*nbsf+n)
+
+public:
+    /** \brief Constructor for the object
+        \param IIao Two-electron integrals in AO basis with chemists indexing,
+                    e.g. (ij|kl) = IIao(i*nbsf+j,k*nbsf+l)
+        \param thresh Screening threshold
+     **/
+    template<typename Tb>
+    eri_screen(const arma::Mat<Tb> &IIao, double thresh);
+
+    /** \brief Destructor **/
+    virtual ~eri_screen() { }
+
+    /** \brief Number of basis functions **/
+    size_t nbsf() const { return m_nbsf; }
+
+    /** \brief Screening threshold **/
+    double thresh() const { return m_thresh; }
+
+    /** \brief Largest Schwarz factor **/
+    double max() const { return m_Qmax; }
+
+    /** \brief Schwarz factors indexed by the pair m*nbsf+n **/
+    const arma::vec &schwarz() const { return m_Q; }
+};
+
+} // namespace libgnme
+
+#endif // LIBGNME_ERI_SCREEN_H
@@ -0,0 +1,153 @@
+#ifndef LIBGNME_GNME_STATS_H
+#define LIBGNME_GNME_STATS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+namespace libgnme {
+
+/** \brief Cumulative timings and operation counts for the library routines
+
+    Statistics are only recorded if the library is compiled with LIBGNME_STATS defined
+    (cmake -DWITH_STATS=ON), and otherwise remain zero. Each thread records into its own
+    copy, and get_stats() returns the sum over all threads. Phases are nested, e.g. the
+    time for setup_two_body includes the build_jk and eri_ao2mo phases it calls.
+
+    Statistics for a single pair of determinants can be obtained by calling reset_stats()
+    before setup_orbitals, and get_stats() after the matrix elements are evaluated.
+    Neither function should be called while other threads are evaluating.
+
+    \ingroup gnme_utils
+ **/
+struct gnme_stats
+{
+    /** \brief Timed phases **/
+    enum phase
+    {
+        lowdin_pair, //!< Lowdin pairing of two sets of orbitals
+        build_jk, //!< Coulomb and exchange matrices in AO basis
+        eri_ao2mo, //!< Two-electron integral transforms
+        setup_orbitals, //!< wick pair setup
+        setup_one_body, //!< wick one-body intermediates
+        setup_two_body, //!< wick two-body intermediates
+        evaluate_overlap, //!< wick::evaluate_overlap
+        evaluate_one_body, //!< wick::evaluate_one_body_spin
+        evaluate, //!< wick::evaluate for a single pair
+        evaluate_1rdm, //!< wick::evaluate_1rdm
+        evaluate_block, //!< wick::evaluate_block
+        slater_setup_pair, //!< slater_uscf pair setup
+        slater_evaluate, //!< slater_uscf::evaluate
+        nphase
+    };
+
+    /** \brief Length of the determinant and permutation counters **/
+    static const size_t max_count = 16;
+
+    double time[nphase]; //!< Wall time for each phase in seconds
+    size_t calls[nphase]; //!< Number of calls for each phase
+    double flops[nphase]; //!< Estimated floating-point operations for each phase
+    size_t ndet[max_count]; //!< Determinants evaluated by excitation rank of the spin channel
+    size_t nperm[max_count]; //!< Zero-distribution permutations by number of zero overlaps
+    double det_flops; //!< Estimated floating-point operations for the determinants
+
+    gnme_stats() { reset(); }
+
+    /** \brief Zero all statistics **/
+    void reset();
+
+    /** \brief Accumulate statistics from another object **/
+    gnme_stats &operator+=(const gnme_stats &other);
+
+    /** \brief Name of a phase **/
+    static const char *name(size_t p);
+
+    /** \brief Print a summary of the non-zero statistics **/
+    void print(std::ostream &os) const;
+};
+
+/** \brief Check whether the library records statistics **/
+bool stats_enabled();
+
+/** \brief Sum of the statistics recorded by all threads **/
+gnme_stats get_stats();
+
+/** \brief Zero the statistics recorded by all threads **/
+void reset_stats();
+
+/** \brief Statistics for the calling thread, registered on first use **/
+gnme_stats *stats_register();
+
+/** \brief Statistics for the calling thread **/
+inline gnme_stats &stats_local()
+{
+    static thread_local gnme_stats *local = stats_register();
+    return *local;
+}
+
+#ifdef LIBGNME_STATS
+
+/** \brief Record the wall time and a call for a phase while in scope **/
+class stats_timer
+{
+private:
+    gnme_stats::phase m_phase;
+    std::chrono::steady_clock::time_point m_start;
+
+public:
+    stats_timer(gnme_stats::phase p, double flops = 0.0) :
+        m_phase(p), m_start(std::chrono::steady_clock::now())
+    {
+        stats_local().flops[p] += flops;
+    }
+
+    ~stats_timer()
+    {
+        gnme_stats &s = stats_local();
+        s.time[m_phase] += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+        s.calls[m_phase]++;
+    }
+
+    stats_timer(const stats_timer &) = delete;
+    stats_timer &operator=(const stats_timer &) = delete;
+};
+
+/** \brief Add floating-point operations to a phase **/
+inline void stats_flops(gnme_stats::phase p, double flops)
+{
+    stats_local().flops[p] += flops;
+}
+
+/** \brief Record determinants of order n evaluated for each zero distribution
+    \param rank Excitation rank of the spin channel
+    \param nz Number of zero overlaps
+    \param nperm Number of zero distributions
+    \param ndet Number of determinants for each distribution
+    \param n Order of the determinants
+ **/
+inline void stats_dets(size_t rank, size_t nz, size_t nperm, size_t ndet, size_t n)
+{
+    gnme_stats &s = stats_local();
+    s.ndet[std::min(rank, gnme_stats::max_count-1)] += nperm * ndet;
+    s.nperm[std::min(nz, gnme_stats::max_count-1)] += nperm;
+    s.det_flops += double(nperm * ndet) * (2.0 * n * n * n / 3.0);
+}
+
+#else
+
+class stats_timer
+{
+public:
+    stats_timer(gnme_stats::phase, double = 0.0) { }
+};
+
+inline void stats_flops(gnme_stats::phase, double) { }
+
+inline void stats_dets(size_t, size_t, size_t, size_t, size_t) { }
+
+#endif
+
+} // namespace libgnme
+
+#endif // LIBGNME_GNME_STATS_H
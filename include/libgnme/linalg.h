@@ -31,6 +31,20 @@ void gen_eig_sym(
     const size_t dim, arma::Mat<T> &M, arma::Mat<T> &S, arma::Mat<T> &X, 
     arma::Col<double> &eigval, arma::Mat<T> &eigvec, double thresh);
 
+/** \brief Compute the determinant and adjugate of a square matrix
+    
+    The adjugate is evaluated from the singular value decomposition, so it remains
+    well-defined for singular matrices. The determinant of M with column i replaced
+    by a vector v is then given by adj(M).row(i) * v.
+
+    \param M Input matrix
+    \param[out] adjM Adjugate matrix of M
+    \return Determinant of M
+    \ingroup gnme_utils
+ **/
+template<typename T>
+T adjugate(const arma::Mat<T> &M, arma::Mat<T> &adjM);
+
 } // namespace libgnme
 
 #endif // LIBGNME_LINALG_H_
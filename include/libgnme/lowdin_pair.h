@@ -1,6 +1,8 @@
 #ifndef LIBGNME_LOWDIN_PAIR_H
 #define LIBGNME_LOWDIN_PAIR_H
 
+#include <utility>
+#include <vector>
 #include <armadillo>
 
 namespace libgnme {
@@ -16,6 +18,60 @@ namespace libgnme {
 template<typename Tc, typename Ti>
 void lowdin_pair(arma::Mat<Tc>& Cw, arma::Mat<Tc>& Cx, arma::Col<Tc>& Sxx, const arma::Mat<Ti>& metric, double thresh=1e-10);
 
+/** \brief Biorthogonalise two sets of orbitals using Lowdin Pairing with precomputed
+           metric-transformed ket orbitals.
+    \param Cw Orbital coefficients in the bra.
+    \param Cx Orbital ceofficients in the ket.
+    \param SCx Metric-transformed orbital coefficients in the ket, rotated along with Cx.
+    \param[out] Sxx Paired overlap eigenvalues.
+    \param thresh Floating-point cutoff threshold for testing whether overlap is diagonal (default 1e-10)
+    \ingroup gnme_utils
+**/
+template<typename Tc>
+void lowdin_pair(arma::Mat<Tc>& Cw, arma::Mat<Tc>& Cx, arma::Mat<Tc>& SCx, arma::Col<Tc>& Sxx, double thresh=1e-10);
+
+/** \brief Biorthogonalise a list of (bra, ket) pairs of orbital sets using Lowdin Pairing.
+
+    The metric-transformed orbitals of each ket are computed once and shared by all of
+    its pairs, and the pairs are distributed over OpenMP threads.
+
+    \param C Orbital coefficients for each state.
+    \param metric Metric matrix corresponding to underlying basis.
+    \param pairs Indices (bra, ket) of the states in each pair.
+    \param[out] Cw Paired bra orbitals for each pair.
+    \param[out] Cx Paired ket orbitals for each pair.
+    \param[out] Sxx Paired overlap eigenvalues for each pair.
+    \param thresh Floating-point cutoff threshold for testing whether overlap is diagonal (default 1e-10)
+    \ingroup gnme_utils
+**/
+template<typename Tc, typename Ti>
+void lowdin_pair(
+    const std::vector<arma::Mat<Tc> > &C, const arma::Mat<Ti> &metric,
+    const std::vector<std::pair<size_t,size_t> > &pairs,
+    std::vector<arma::Mat<Tc> > &Cw, std::vector<arma::Mat<Tc> > &Cx,
+    std::vector<arma::Col<Tc> > &Sxx, double thresh=1e-10);
+
+/** \brief Biorthogonalise the ket orbitals against the bra using an LU decomposition.
+
+    The ket orbitals are transformed to Cx Swx^-1, so that all paired overlaps are one and
+    the overlap Ov = det(Swx) is carried separately. This is cheaper than Lowdin Pairing
+    when only the overlap and co-density matrices are needed, but cannot identify zero
+    overlaps. Nothing is changed and false is returned if the smallest singular value
+    of Swx could be below thresh, in which case lowdin_pair should be used instead.
+
+    \param Cw Orbital coefficients in the bra.
+    \param Cx Orbital coefficients in the ket.
+    \param SCx Metric-transformed orbital coefficients in the ket.
+    \param[out] Ov Overlap of the two determinants.
+    \param thresh Floating-point cutoff threshold for zero biorthogonal orbital overlap (default 1e-8)
+    \return Whether the biorthogonalisation succeeded
+    \ingroup gnme_utils
+**/
+template<typename Tc>
+bool lu_biorthogonalise(
+    const arma::Mat<Tc> &Cw, arma::Mat<Tc> &Cx, const arma::Mat<Tc> &SCx,
+    Tc &Ov, double thresh=1e-8);
+
 /** \brief Compute inverse overlap, reduced overlap and locate orbital pairs with zero overlap.
     \param Sxx Paired overlap eigenvalues.
     \param[out] invSxx Inverse paired overlap eigenvalues (0 where Sxx[i] = 0)
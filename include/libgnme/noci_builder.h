@@ -0,0 +1,109 @@
+#ifndef LIBGNME_NOCI_BUILDER_H
+#define LIBGNME_NOCI_BUILDER_H
+
+#include <armadillo>
+
+namespace libgnme {
+
+/** \brief Build the Hamiltonian and overlap matrices for a set of reference
+           determinants and their excitations
+
+    The per-determinant intermediates are computed once in a det_registry. Each pair
+    of reference determinants is then set up with its own wick object in an OpenMP 
+    task, and the rows of each block are evaluated as further tasks, so the work within
+    a single large block is also shared between threads. Only the upper triangle is 
+    evaluated, with the lower triangle obtained from Hermiticity.
+
+    \tparam Tc Type defining orbital coefficients
+    \tparam Tf Type defining one-body matrix elements
+    \tparam Tb Type defining basis functions
+    \ingroup gnme_wick
+ **/
+template<typename Tc, typename Tf, typename Tb>
+class noci_builder
+{
+private:
+    /* Useful constants */
+    const size_t m_nbsf; //!< Number of basis functions
+    const size_t m_nmo; //!< Number of (linearly independent) MOs
+    const size_t m_nalpha; //!< Number of alpha electrons
+    const size_t m_nbeta; //!< Number of beta electrons
+    const arma::Mat<Tb> &m_metric; //!< Basis overlap metric
+
+    double m_Vc; //!< constant component
+    arma::Mat<Tf> m_Fa; //!< Fock matrices
+    arma::Mat<Tf> m_Fb; //!< Fock matrices
+    arma::Mat<Tb> *m_II = nullptr; //!< Pointer to two-body integrals
+    arma::Cube<Tb> *m_L = nullptr; //!< Pointer to three-index two-body factors
+
+    bool m_one_body = false;
+
+public:
+    /** \brief Constructor for the object
+        \param nbsf Number of basis functions
+        \param nmo Number of linearly independent molecular orbitals
+        \param nalpha Number of high-spin electrons
+        \param nbeta Number of low-spin electrons
+        \param metric Overlap matrix of the basis functions
+        \param Vc Constant term in the corresponding operator
+     **/
+    noci_builder(
+        const size_t nbsf, const size_t nmo,
+        const size_t nalpha, const size_t nbeta,
+        const arma::Mat<Tb> &metric, double Vc=0) :
+        m_nbsf(nbsf), m_nmo(nmo), m_nalpha(nalpha), m_nbeta(nbeta), m_metric(metric), m_Vc(Vc)
+    { }
+
+    /** \brief Destructor **/
+    virtual ~noci_builder() { }
+
+    /** \name Routines to add one- or two-body operators to the object **/
+    ///@{
+
+    /** \brief Add a one-body operator with spin-restricted integrals
+        \param F One-body integrals in AO basis
+     **/
+    virtual void add_one_body(arma::Mat<Tf> &F);
+
+    /** \brief Add a one-body operator with spin-unrestricted integrals
+        \param Fa One-body integrals for high-spin component in AO basis
+        \param Fb One-body integrals for low-spin component in AO basis
+     **/
+    virtual void add_one_body(arma::Mat<Tf> &Fa, arma::Mat<Tf> &Fb);
+
+    /** \brief Add a two-body operator with spin-restricted integrals
+        \param V Two-body integrals in AO basis. These are represented as matrices in chemists
+                  notation, e.g. (ij|kl) = V(i*nbsf+j,k*nbsf+l)
+     **/
+    virtual void add_two_body(arma::Mat<Tb> &V);
+
+    /** \brief Add a two-body operator with spin-restricted factorised integrals
+        \param L Three-index Cholesky or density-fitting factors in AO basis,
+                  e.g. (ij|kl) = sum_P L(i,j,P) * L(k,l,P)
+     **/
+    virtual void add_two_body(arma::Cube<Tb> &L);
+    ///@}
+
+    /** \brief Build the matrices in the space of excitations from each reference
+        \param C Cube containing the reference determinant orbitals [Ca, Cb]
+        \param ex Field with an entry for each reference, containing a field (nex x 2)
+                  of the alpha and beta particle-hole excitations from that reference
+        \param[out] H Matrix of operator matrix elements
+        \param[out] S Matrix of overlap matrix elements
+     **/
+    virtual void build(
+        const arma::Cube<Tc> &C, const arma::field<arma::field<arma::umat> > &ex,
+        arma::Mat<Tc> &H, arma::Mat<Tc> &S);
+
+    /** \brief Build the matrices in the space of reference determinants
+        \param C Cube containing the reference determinant orbitals [Ca, Cb]
+        \param[out] H Matrix of operator matrix elements
+        \param[out] S Matrix of overlap matrix elements
+     **/
+    virtual void build(
+        const arma::Cube<Tc> &C, arma::Mat<Tc> &H, arma::Mat<Tc> &S);
+};
+
+} // namespace libgnme
+
+#endif // LIBGNME_NOCI_BUILDER_H
@@ -1,6 +1,8 @@
 #ifndef LIBGNME_SLATER_USCF_H 
 #define LIBGNME_SLATER_USCF_H
 
+#include <utility>
+#include <vector>
 #include <armadillo>
 #include <cassert>
 
@@ -27,7 +29,11 @@ private:
     double m_Vc; //!< constant component
     arma::Mat<Tf> m_Fa; //!< Fock matrices
     arma::Mat<Tf> m_Fb; //!< Fock matrices
-    arma::Mat<Tb> m_II; //!< Two-body integrals
+    Tb *m_II = nullptr; //!< Pointer to two-body integral memory
+    Tb *m_L = nullptr; //!< Pointer to three-index two-body factor memory
+    size_t m_naux = 0; //!< Number of three-index two-body factors
+    double m_screen_thresh = 0.0; //!< Schwarz screening threshold (disabled if zero)
+    double m_screen_err = 0.0; //!< Bound on neglected two-electron contributions
 
     // Control variables for different components
     bool m_one_body = false;
@@ -85,7 +91,8 @@ public:
 
     /** \brief Add a two-body operator with spin-restricted integrals
         \param V Two-body integrals in AO basis. These are represented as matrices in chemists
-                  notation, e.g. (ij|kl) = V(i*nbsf+j,k*nbsf+l)
+                  notation, e.g. (ij|kl) = V(i*nbsf+j,k*nbsf+l). The integrals are not 
+                  copied, and must remain valid while the object is used.
      **/
     virtual void add_two_body(arma::Mat<Tb> &II)
     {
@@ -94,13 +101,49 @@ public:
         assert(II.n_cols == m_nbsf * m_nbsf);
 
         // Save two-body integrals
-        m_II = II;
+        m_II = II.memptr();
+        m_L = nullptr; m_naux = 0;
 
         // Setup control variable to indicate one-body initialised
         m_two_body = true;
     }
+
+    /** \brief Add a two-body operator with spin-restricted factorised integrals
+        \param L Three-index Cholesky or density-fitting factors in AO basis, 
+                  e.g. (ij|kl) = sum_P L(i,j,P) * L(k,l,P). The factors are not
+                  copied, and must remain valid while the object is used.
+     **/
+    virtual void add_two_body(arma::Cube<Tb> &L)
+    {
+        // Check input
+        assert(L.n_rows == m_nbsf);
+        assert(L.n_cols == m_nbsf);
+
+        // Save two-body factors
+        m_L = L.memptr();
+        m_naux = L.n_slices;
+        m_II = nullptr;
+
+        // Setup control variable to indicate two-body initialised
+        m_two_body = true;
+    }
     ///@}
 
+    /** \brief Set the threshold for Schwarz screening of the AO two-electron integrals
+
+        When the threshold is positive, contributions to the Coulomb and exchange 
+        matrices are skipped if their Schwarz bound, weighted by the co-densities, is 
+        below the threshold. Screening only applies to four-index integrals.
+
+        \param thresh Screening threshold, or zero to disable screening
+     **/
+    virtual void set_screening(double thresh) { m_screen_thresh = thresh; }
+
+    /** \brief Upper bound on the neglected contribution to any element of the AO 
+               Coulomb and exchange matrices in the last evaluation
+     **/
+    virtual double screening_error() const { return m_screen_err; }
+
     virtual void evaluate_overlap(
         arma::Mat<Tc> Cxa, arma::Mat<Tc> Cxb,
         arma::Mat<Tc> Cwa, arma::Mat<Tc> Cwb,
@@ -109,6 +152,87 @@ public:
         arma::Mat<Tc> Cxa, arma::Mat<Tc> Cxb,
         arma::Mat<Tc> Cwa, arma::Mat<Tc> Cwb,
         Tc &Ov, Tc &H);
+
+    /** \brief Evaluate the overlap and matrix elements for a batch of determinant pairs
+
+        The pairs are set up in parallel, and the Coulomb and exchange matrices for 
+        all pairs are then built together in a single pass over the integrals. 
+
+        \param Cxa Field of bra occupied orbital coefficients (alpha)
+        \param Cxb Field of bra occupied orbital coefficients (beta)
+        \param Cwa Field of ket occupied orbital coefficients (alpha)
+        \param Cwb Field of ket occupied orbital coefficients (beta)
+        \param[out] Ov Vector of overlap matrix elements
+        \param[out] H Vector of operator matrix elements
+     **/
+    virtual void evaluate(
+        const arma::field<arma::Mat<Tc> > &Cxa, const arma::field<arma::Mat<Tc> > &Cxb,
+        const arma::field<arma::Mat<Tc> > &Cwa, const arma::field<arma::Mat<Tc> > &Cwb,
+        arma::Col<Tc> &Ov, arma::Col<Tc> &H);
+
+    /** \brief Evaluate the overlap and matrix elements for a list of pairs of states
+
+        All pairs are Lowdin paired together, so the metric-transformed ket orbitals of
+        each state are only formed once. The Coulomb and exchange matrices for all pairs 
+        are then built together in a single pass over the integrals.
+
+        \param Ca Occupied orbital coefficients of each state (alpha)
+        \param Cb Occupied orbital coefficients of each state (beta)
+        \param pairs Indices (bra, ket) of the states in each pair
+        \param[out] Ov Vector of overlap matrix elements
+        \param[out] H Vector of operator matrix elements
+     **/
+    virtual void evaluate(
+        const std::vector<arma::Mat<Tc> > &Ca, const std::vector<arma::Mat<Tc> > &Cb,
+        const std::vector<std::pair<size_t,size_t> > &pairs,
+        arma::Col<Tc> &Ov, arma::Col<Tc> &H);
+
+private:
+    /** \brief Setup the terms for a pair of determinants
+        
+        The two-body energy is sum_d [ J(D_d).Wj_d - K(D_d).Wk_d ], with the Coulomb 
+        and exchange matrices built from the co-densities D by the caller.
+
+        \param[out] Ov Overlap matrix element
+        \param[out] redOv Reduced overlap
+        \param[out] H Constant and one-body contributions, without the reduced overlap
+        \param[out] D Co-densities for the Coulomb and exchange matrices
+        \param[out] Wj Co-densities contracted with the Coulomb matrices
+        \param[out] Wk Co-densities contracted with the exchange matrices
+     **/
+    void setup_pair(
+        arma::Mat<Tc> Cxa, arma::Mat<Tc> Cxb,
+        arma::Mat<Tc> Cwa, arma::Mat<Tc> Cwb,
+        Tc &Ov, Tc &redOv, Tc &H, arma::field<arma::Mat<Tc> > &D,
+        arma::field<arma::Mat<Tc> > &Wj, arma::field<arma::Mat<Tc> > &Wk);
+
+    /** \brief Setup the terms for a pair of determinants with Lowdin-paired orbitals
+        \param Sxx_a Paired overlaps (alpha)
+        \param Sxx_b Paired overlaps (beta)
+        \param rscf Whether the alpha and beta orbitals and operators are identical
+     **/
+    void setup_paired(
+        const arma::Mat<Tc> &Cxa, const arma::Mat<Tc> &Cxb,
+        const arma::Mat<Tc> &Cwa, const arma::Mat<Tc> &Cwb,
+        const arma::Col<Tc> &Sxx_a, const arma::Col<Tc> &Sxx_b, bool rscf,
+        Tc &Ov, Tc &redOv, Tc &H, arma::field<arma::Mat<Tc> > &D,
+        arma::field<arma::Mat<Tc> > &Wj, arma::field<arma::Mat<Tc> > &Wk);
+
+    /** \brief Whether a determinant has identical alpha and beta orbitals and operators **/
+    bool spin_restricted(const arma::Mat<Tc> &Ca, const arma::Mat<Tc> &Cb) const;
+
+    /** \brief Add the two-body terms for a batch of pairs set up by setup_pair, 
+               and account for the reduced overlaps
+     **/
+    void contract_two_body(
+        const arma::Col<Tc> &redOv, arma::field<arma::field<arma::Mat<Tc> > > &D,
+        const arma::field<arma::field<arma::Mat<Tc> > > &Wj, 
+        const arma::field<arma::field<arma::Mat<Tc> > > &Wk, arma::Col<Tc> &H);
+
+    /** \brief Build the Coulomb and exchange matrices for a set of co-densities **/
+    void compute_jk(
+        const arma::field<arma::Mat<Tc> > &D, 
+        arma::field<arma::Mat<Tc> > &J, arma::field<arma::Mat<Tc> > &K);
 };
 
 } // namespace libgnme
@@ -0,0 +1,168 @@
+#ifndef LIBGNME_SMALL_DET_H
+#define LIBGNME_SMALL_DET_H
+
+#include <cassert>
+#include <cstddef>
+
+namespace libgnme {
+
+/** Largest matrix dimension handled by the fixed-size determinant kernels **/
+const size_t small_det_max = 4;
+
+/** \brief Fixed-size kernels for the determinant and adjugate of an N x N matrix
+
+    Matrices are stored as column-major arrays on the stack. The adjugate is
+    stored such that the determinant of A with column k replaced by a vector v
+    is given by sum_r adj[k+N*r] v[r].
+
+    \tparam N Dimension of the matrix
+    \tparam T Numerical type
+    \ingroup gnme_utils
+ **/
+template<size_t N, typename T>
+struct fixed_det
+{
+    /** \brief Copy A into M with row i and column j removed **/
+    static inline void minor(const T *A, size_t i, size_t j, T *M)
+    {
+        for(size_t q=0, qm=0; q < N; q++)
+        {
+            if(q == j) continue;
+            for(size_t p=0, pm=0; p < N; p++)
+            {
+                if(p == i) continue;
+                M[pm + (N-1)*qm] = A[p + N*q];
+                pm++;
+            }
+            qm++;
+        }
+    }
+
+    /** \brief Compute the determinant by expansion along the first column **/
+    static inline T det(const T *A)
+    {
+        T M[(N-1)*(N-1)];
+        T d = 0.0;
+        for(size_t i=0; i < N; i++)
+        {
+            minor(A, i, 0, M);
+            T c = A[i] * fixed_det<N-1,T>::det(M);
+            d += (i % 2) ? -c : c;
+        }
+        return d;
+    }
+
+    /** \brief Compute the adjugate and return the determinant **/
+    static inline T adjugate(const T *A, T *adj)
+    {
+        T M[(N-1)*(N-1)];
+        for(size_t j=0; j < N; j++)
+        for(size_t i=0; i < N; i++)
+        {
+            minor(A, i, j, M);
+            T c = fixed_det<N-1,T>::det(M);
+            adj[j + N*i] = ((i+j) % 2) ? -c : c;
+        }
+        T d = 0.0;
+        for(size_t i=0; i < N; i++)
+            d += A[i] * adj[N*i];
+        return d;
+    }
+};
+
+template<typename T>
+struct fixed_det<3,T>
+{
+    static inline T det(const T *A)
+    {
+        return A[0] * (A[4] * A[8] - A[7] * A[5])
+             - A[3] * (A[1] * A[8] - A[7] * A[2])
+             + A[6] * (A[1] * A[5] - A[4] * A[2]);
+    }
+    static inline T adjugate(const T *A, T *adj)
+    {
+        adj[0] =   A[4] * A[8] - A[7] * A[5];
+        adj[1] = - A[1] * A[8] + A[7] * A[2];
+        adj[2] =   A[1] * A[5] - A[4] * A[2];
+        adj[3] = - A[3] * A[8] + A[6] * A[5];
+        adj[4] =   A[0] * A[8] - A[6] * A[2];
+        adj[5] = - A[0] * A[5] + A[3] * A[2];
+        adj[6] =   A[3] * A[7] - A[6] * A[4];
+        adj[7] = - A[0] * A[7] + A[6] * A[1];
+        adj[8] =   A[0] * A[4] - A[3] * A[1];
+        return A[0] * adj[0] + A[1] * adj[3] + A[2] * adj[6];
+    }
+};
+
+template<typename T>
+struct fixed_det<2,T>
+{
+    static inline T det(const T *A)
+    {
+        return A[0] * A[3] - A[2] * A[1];
+    }
+    static inline T adjugate(const T *A, T *adj)
+    {
+        adj[0] =  A[3]; adj[2] = -A[2];
+        adj[1] = -A[1]; adj[3] =  A[0];
+        return A[0] * A[3] - A[2] * A[1];
+    }
+};
+
+template<typename T>
+struct fixed_det<1,T>
+{
+    static inline T det(const T *A) { return A[0]; }
+    static inline T adjugate(const T *A, T *adj) { adj[0] = 1.0; return A[0]; }
+};
+
+template<typename T>
+struct fixed_det<0,T>
+{
+    static inline T det(const T *) { return 1.0; }
+    static inline T adjugate(const T *, T *) { return 1.0; }
+};
+
+/** \brief Determinant of a small column-major n x n matrix, with n <= small_det_max
+    \param n Dimension of the matrix
+    \param A Pointer to matrix elements
+    \ingroup gnme_utils
+ **/
+template<typename T>
+inline T small_det(size_t n, const T *A)
+{
+    assert(n <= small_det_max);
+    switch(n)
+    {
+        case 0: return fixed_det<0,T>::det(A);
+        case 1: return fixed_det<1,T>::det(A);
+        case 2: return fixed_det<2,T>::det(A);
+        case 3: return fixed_det<3,T>::det(A);
+        default: return fixed_det<4,T>::det(A);
+    }
+}
+
+/** \brief Adjugate and determinant of a small column-major n x n matrix, with n <= small_det_max
+    \param n Dimension of the matrix
+    \param A Pointer to matrix elements
+    \param[out] adj Pointer to adjugate matrix elements
+    \return Determinant of A
+    \ingroup gnme_utils
+ **/
+template<typename T>
+inline T small_adjugate(size_t n, const T *A, T *adj)
+{
+    assert(n <= small_det_max);
+    switch(n)
+    {
+        case 0: return fixed_det<0,T>::adjugate(A, adj);
+        case 1: return fixed_det<1,T>::adjugate(A, adj);
+        case 2: return fixed_det<2,T>::adjugate(A, adj);
+        case 3: return fixed_det<3,T>::adjugate(A, adj);
+        default: return fixed_det<4,T>::adjugate(A, adj);
+    }
+}
+
+} // namespace libgnme
+
+#endif // LIBGNME_SMALL_DET_H
@@ -6,6 +6,11 @@
 namespace libgnme {
 
 /** \brief Compute NOCI density matrix with RSCF reference orbitals.
+
+    Pairs of reference states are distributed over OpenMP threads, each accumulating
+    a partial density matrix that is summed at the end. The same scheme is used for
+    the USCF and GSCF variants below.
+
     \param C Cube containing RSCF reference determinant orbitals.
     \param Anoci Vector of NOCI coefficients.
     \param metric Atomic orbital metric (overlap) matrix.
@@ -17,7 +22,7 @@ namespace libgnme {
  **/
 template<typename Tc, typename Tb>
 void rscf_noci_density(
-    arma::Cube<Tc> C, const arma::Col<Tc> Anoci, const arma::Mat<Tb> metric, 
+    const arma::Cube<Tc> &C, const arma::Col<Tc> &Anoci, const arma::Mat<Tb> &metric, 
     const size_t nmo, const size_t nbsf, const size_t nelec, const size_t nstates,
     arma::Mat<Tc> &P); 
 
@@ -33,7 +38,7 @@ void rscf_noci_density(
  **/
 template<typename Tc, typename Tb>
 void uscf_noci_density(
-    arma::Cube<Tc> C, const arma::Col<Tc> Anoci, const arma::Mat<Tb> metric, 
+    const arma::Cube<Tc> &C, const arma::Col<Tc> &Anoci, const arma::Mat<Tb> &metric, 
     const size_t nmo, const size_t nbsf, const size_t nalpha, const size_t nbeta, const size_t nstates,
     arma::Mat<Tc> &P); 
 
@@ -50,7 +55,7 @@ void uscf_noci_density(
  **/
 template<typename Tc, typename Tb>
 void uscf_noci_density(
-    arma::Cube<Tc> C, const arma::Col<Tc> Anoci, const arma::Mat<Tb> metric, 
+    const arma::Cube<Tc> &C, const arma::Col<Tc> &Anoci, const arma::Mat<Tb> &metric, 
     const size_t nmo, const size_t nbsf, const size_t nalpha, const size_t nbeta, const size_t nstates,
     arma::Mat<Tc> &Pa, arma::Mat<Tc> &Pb); 
 
@@ -66,7 +71,7 @@ void uscf_noci_density(
  **/
 template<typename Tc, typename Tb>
 void gscf_noci_density(
-    arma::Cube<Tc> C, const arma::Col<Tc> Anoci, const arma::Mat<Tb> metric, 
+    const arma::Cube<Tc> &C, const arma::Col<Tc> &Anoci, const arma::Mat<Tb> &metric, 
     const size_t nmo, const size_t nbsf, const size_t nelec, const size_t nstates,
     arma::Mat<Tc> &P); 
 
@@ -1,7 +1,12 @@
 #ifndef LIBGNME_WICK_H 
 #define LIBGNME_WICK_H
 
+#include <memory>
+#include <string>
+#include <utility>
 #include <armadillo>
+#include "det_registry.h"
+#include "wick_workspace.h"
 
 namespace libgnme {
 
@@ -27,17 +32,38 @@ private:
     arma::Mat<Tf> m_Fa; //!< Fock matrices
     arma::Mat<Tf> m_Fb; //!< Fock matrices
     Tb *m_II; //!< Pointer to two-body integral memory
+    Tb *m_L = nullptr; //!< Pointer to three-index two-body factor memory
+    size_t m_naux = 0; //!< Number of three-index two-body factors
+
+    size_t m_max_mem = 1024; //!< Memory limit for integral transform scratch (MB)
+    arma::Col<Tc> m_work; //!< Reusable scratch memory for integral transforms
+    double m_screen_thresh = 0.0; //!< Schwarz screening threshold (disabled if zero)
+    double m_screen_err = 0.0; //!< Bound on neglected two-electron contributions
 
     // One-body MO matrices
     bool m_one_body = false;
     bool m_two_body = false;
 
+    // Frozen core shared by all determinants
+    size_t m_ncore = 0; //!< Number of frozen core orbitals
+    bool m_core_built = false; //!< Whether the core terms are up to date
+    arma::Mat<Tc> m_Cc; //!< Frozen core coefficients [alpha, beta]
+    arma::Mat<Tc> m_Pca; //!< Core density matrix (alpha)
+    arma::Mat<Tc> m_Pcb; //!< Core density matrix (beta)
+    arma::Mat<Tc> m_Fca; //!< One-body operator including the core (alpha)
+    arma::Mat<Tc> m_Fcb; //!< One-body operator including the core (beta)
+    Tc m_Ecore = 0.0; //!< Core contribution to the constant term
+
     /* Information about this pair */
 public:
     size_t m_nza; //!< Number of alpha zero-overlap orbitals
     size_t m_nzb; //!< Number of beta zero-overlap orbitals
 
 private:
+    bool m_rscf = false; //!< Whether the alpha and beta channels are identical
+    bool m_pair_one_body = false; //!< Whether the one-body intermediates are set up for this pair
+    bool m_pair_two_body = false; //!< Whether the two-body intermediates are set up for this pair
+
     // Reference reduced overlaps
     Tc m_redSa; //!< Reduced overlap
     Tc m_redSb; //!< Reduced overlap
@@ -85,36 +111,12 @@ private:
     arma::field<arma::Mat<Tc> > m_XVaXb;
     arma::field<arma::Mat<Tc> > m_XVbXa;
 
-    // Store two-electron repulsion integrals (16 * nmo^4)
-    arma::field<arma::Mat<Tc> > m_IIaa;
-    arma::field<arma::Mat<Tc> > m_IIbb;
-    arma::field<arma::Mat<Tc> > m_IIab;
-    arma::field<arma::Mat<Tc> > m_IIba;
-
-    // Holds the `X' matrices
-    // TODO: Remove
-    arma::field<arma::Mat<Tc> > m_wwXa;
-    arma::field<arma::Mat<Tc> > m_wxXa;
-    arma::field<arma::Mat<Tc> > m_xwXa;
-    arma::field<arma::Mat<Tc> > m_xxXa;
-    arma::field<arma::Mat<Tc> > m_wwXb;
-    arma::field<arma::Mat<Tc> > m_wxXb;
-    arma::field<arma::Mat<Tc> > m_xwXb;
-    arma::field<arma::Mat<Tc> > m_xxXb;
-
-    // Hold the 'CX' and 'CY' matrices
-    // TODO: Remove
-    arma::field<arma::Mat<Tc> > m_xCXa;
-    arma::field<arma::Mat<Tc> > m_xCXb;
-    arma::field<arma::Mat<Tc> > m_wCXa;
-    arma::field<arma::Mat<Tc> > m_wCXb;
-
-    // Hold the 'XC' and 'YC' matrices
-    // TODO: Remove
-    arma::field<arma::Mat<Tc> > m_xXCa;
-    arma::field<arma::Mat<Tc> > m_xXCb;
-    arma::field<arma::Mat<Tc> > m_wXCa;
-    arma::field<arma::Mat<Tc> > m_wXCb;
+    // Store antisymmetrised two-electron integrals in one contiguous block.
+    // Same-spin blocks (ij,kl) and (kl,ij) are related by transposition, so 
+    // only the blocks with ij <= kl are kept.
+    arma::Col<Tc> m_IImem; //!< Two-electron integral memory
+    size_t m_IIoff[3] = {0, 0, 0}; //!< Offsets of the aa, bb and ab integrals
+    std::shared_ptr<const void> m_map; //!< Memory-mapped snapshot holding the integrals, if any
 
 public:
     /** \brief Constructor for the object
@@ -142,6 +144,28 @@ public:
     virtual void setup_orbitals(arma::Mat<Tc> Cx, arma::Mat<Tc> Cw);
     virtual void setup_orbitals(arma::Mat<Tc> Cx, arma::Mat<Tc> Cw, size_t ncore, size_t nactive);
 
+    /** \brief Setup orbitals using cached intermediates for the reference determinants
+        \param reg Registry containing the reference determinants
+        \param ix Index of the bra state in the registry
+        \param iw Index of the ket state in the registry
+     **/
+    virtual void setup_orbitals(const det_registry<Tc,Tb> &reg, size_t ix, size_t iw);
+    virtual void setup_orbitals(
+        const det_registry<Tc,Tb> &reg, size_t ix, size_t iw, size_t ncore, size_t nactive);
+
+    /** \brief Setup orbitals with precomputed metric-transformed coefficients
+        \param Cx Molecular orbital coefficients for the bra state
+        \param SCx Metric-transformed coefficients for the bra state
+        \param Cw Molecular orbital coefficients for the ket state
+        \param SCw Metric-transformed coefficients for the ket state
+        \param ncore Number of core orbitals
+        \param nactive Number of active orbitals
+     **/
+    virtual void setup_orbitals(
+        const arma::Mat<Tc> &Cx, const arma::Mat<Tc> &SCx, 
+        const arma::Mat<Tc> &Cw, const arma::Mat<Tc> &SCw, 
+        size_t ncore, size_t nactive);
+
     /** \name Routines to add one- or two-body operators to the object **/
     ///@{
     
@@ -161,43 +185,393 @@ public:
                   notation, e.g. (ij|kl) = V(i*nbsf+j,k*nbsf+l)
      **/
     virtual void add_two_body(arma::Mat<Tb> &V);
+
+    /** \brief Add a two-body operator with spin-restricted factorised integrals
+        \param L Three-index Cholesky or density-fitting factors in AO basis, 
+                  e.g. (ij|kl) = sum_P L(i,j,P) * L(k,l,P)
+     **/
+    virtual void add_two_body(arma::Cube<Tb> &L);
     ///@}
 
+    /** \brief Fold a frozen core shared by all determinants into the operators
+        
+        The core contributes a constant term and an effective one-body operator, so 
+        only the active electrons are paired and contracted in setup_orbitals. The 
+        ncore argument of setup_orbitals must then match the number of core orbitals, 
+        and the core must be orthogonal to the active orbitals of every determinant.
+
+        \param Cc Core orbital coefficients (nbsf x 2*ncore) [alpha, beta]
+     **/
+    virtual void add_frozen_core(const arma::Mat<Tc> &Cc);
+
+    /** \brief Estimate the memory needed by the intermediates for a pair of determinants
+        \param nact Number of active orbitals
+        \return Memory in bytes, assuming both spins have zero overlaps
+     **/
+    virtual size_t memory_estimate(size_t nact) const;
+
+    /** \brief Memory used by the intermediates for the current pair of determinants
+        \return Memory in bytes
+     **/
+    virtual size_t memory_estimate() const;
+
+    /** \brief Whether the current pair was set up in spin-restricted mode
+
+        This is detected in setup_orbitals when both determinants have identical alpha 
+        and beta orbitals, nalpha == nbeta, and the operators are the same for both spins. 
+        Only the alpha intermediates are then constructed, and the bb two-electron 
+        integrals are obtained from the ab integrals.
+     **/
+    bool spin_restricted() const { return m_rscf; }
+
+    /** \brief Save the intermediates for the current pair of determinants to a binary file
+
+        The snapshot contains the reduced overlaps, zero-overlap counts, contractions, 
+        one- and two-body intermediates and the MO two-electron integrals, so that 
+        matrix elements can be evaluated after load_snapshot without calling setup_orbitals.
+        The format is versioned, and the integrals are aligned so that they can be mapped
+        directly into memory.
+
+        \param fname Path of the snapshot file
+     **/
+    virtual void save_snapshot(const std::string &fname) const;
+
+    /** \brief Restore the intermediates for a pair of determinants from a snapshot file
+
+        The file is memory-mapped read-only. The two-electron integrals are used in place, 
+        so processes loading the same snapshot share a single copy through the page cache. 
+        The mapping is released when the object is destroyed or setup_orbitals builds new 
+        two-electron integrals. The dimensions and scalar type must match those of this object.
+        Only the pair intermediates and their screening_error() are restored: operators 
+        must still be added before setup_orbitals is called for a new pair.
+
+        \param fname Path of the snapshot file
+     **/
+    virtual void load_snapshot(const std::string &fname);
+
+    /** \brief Set the memory limit for the scratch space used in two-electron integral transforms
+        \param max_mem Memory limit in MB
+     **/
+    virtual void set_max_memory(size_t max_mem) { m_max_mem = max_mem; }
+
+    /** \brief Set the threshold for Schwarz screening of the AO two-electron integrals
+
+        When the threshold is positive, contributions to the Coulomb and exchange 
+        matrices and the MO integrals built in setup_orbitals are skipped if their 
+        Schwarz bound, weighted by the co-densities or orbital coefficients, is below 
+        the threshold. Screening only applies to four-index integrals.
+
+        \param thresh Screening threshold, or zero to disable screening
+     **/
+    virtual void set_screening(double thresh) { m_screen_thresh = thresh; }
+
+    /** \brief Upper bound on the neglected contribution to any element of the AO 
+               Coulomb and exchange matrices or MO integrals in the last setup_orbitals
+     **/
+    virtual double screening_error() const { return m_screen_err; }
+
+    /** \brief Upper bound on the screening error in a weighted sum of matrix elements,
+               sum_k c(k) M(k), from screening_error() and the magnitudes of the 
+               coefficients that multiply each screened intermediate
+        \param xhp Field (npair x 2) of bra excitations
+        \param whp Field (npair x 2) of ket excitations
+        \param c Weight of each pair
+     **/
+    virtual double screening_error(
+        const arma::field<arma::umat> &xhp, const arma::field<arma::umat> &whp,
+        const arma::Col<Tc> &c) const;
+
     virtual void evaluate_overlap(
-        arma::umat &xa_hp, arma::umat &xb_hp,
-        arma::umat &wa_hp, arma::umat &wb_hp,
-        Tc &S);
+        const arma::umat &xa_hp, const arma::umat &xb_hp,
+        const arma::umat &wa_hp, const arma::umat &wb_hp,
+        Tc &S) const;
     virtual void evaluate_one_body_spin(
-        arma::umat &xhp, arma::umat &whp,
-        Tc &S, Tc &V, bool alpha);
+        const arma::umat &xhp, const arma::umat &whp,
+        Tc &S, Tc &V, bool alpha) const;
     virtual void evaluate(
-        arma::umat &xa_hp, arma::umat &xb_hp,
-        arma::umat &wa_hp, arma::umat &wb_hp,
-        Tc &S, Tc &M);
+        const arma::umat &xa_hp, const arma::umat &xb_hp,
+        const arma::umat &wa_hp, const arma::umat &wb_hp,
+        Tc &S, Tc &M) const;
 
     virtual void evaluate_1rdm(
-        arma::umat &xa_hp, arma::umat &xb_hp,
-        arma::umat &wa_hp, arma::umat &wb_hp,
-        Tc &S, arma::Mat<Tc> &P);
+        const arma::umat &xa_hp, const arma::umat &xb_hp,
+        const arma::umat &wa_hp, const arma::umat &wb_hp,
+        Tc &S, arma::Mat<Tc> &P) const;
+
+    /** \name Batched evaluation over lists of excitations
+        Each excitation descriptor is a row of a field with two columns, containing 
+        the alpha and beta particle-hole matrices respectively. These routines are 
+        const and distribute the batch over OpenMP threads.
+     **/
+    ///@{
+
+    /** \brief Evaluate the overlap and matrix elements for a list of excitation pairs
+        \param xhp Field (npair x 2) of bra excitations
+        \param whp Field (npair x 2) of ket excitations
+        \param[out] S Vector of overlap matrix elements
+        \param[out] M Vector of operator matrix elements
+     **/
+    virtual void evaluate(
+        const arma::field<arma::umat> &xhp, const arma::field<arma::umat> &whp,
+        arma::Col<Tc> &S, arma::Col<Tc> &M) const;
+
+    /** \brief Accumulate the action of the overlap and operator on a CI vector 
+        \param xhp Field (nbra x 2) of bra excitations
+        \param whp Field (nket x 2) of ket excitations
+        \param c CI coefficients for the ket excitations
+        \param[out] sigmaS Vector incremented by sum_J S(I,J) c(J), initialised to zero if empty
+        \param[out] sigmaM Vector incremented by sum_J M(I,J) c(J), initialised to zero if empty
+     **/
+    virtual void evaluate_sigma(
+        const arma::field<arma::umat> &xhp, const arma::field<arma::umat> &whp,
+        const arma::Col<Tc> &c, arma::Col<Tc> &sigmaS, arma::Col<Tc> &sigmaM) const;
+
+    /** \brief Evaluate the matrix elements between two product spaces of alpha and beta excitations
+
+        The bra states are all combinations of an alpha excitation from xa_hp and a beta
+        excitation from xb_hp, with index I = ia * nxb + ib, and similarly for the ket states.
+        Elements are evaluated for each pair of alpha excitations in turn, so the spin 
+        overlap, one-body and same-spin terms are computed once per spin pair, and the 
+        alpha determinants and cofactors are shared by all pairs of beta excitations.
+
+        \param xa_hp Field of bra alpha excitations
+        \param xb_hp Field of bra beta excitations
+        \param wa_hp Field of ket alpha excitations
+        \param wb_hp Field of ket beta excitations
+        \param[out] S Matrix of overlap matrix elements
+        \param[out] M Matrix of operator matrix elements
+     **/
+    virtual void evaluate_block(
+        const arma::field<arma::umat> &xa_hp, const arma::field<arma::umat> &xb_hp,
+        const arma::field<arma::umat> &wa_hp, const arma::field<arma::umat> &wb_hp,
+        arma::Mat<Tc> &S, arma::Mat<Tc> &M) const;
+
+    /** \brief Accumulate the weighted transition density matrices for a list of excitation pairs
+
+        The coefficients of the one- and two-body contractions are accumulated over all pairs
+        in the basis of the active bra and ket orbitals, and transformed to the AO basis once.
+        Each thread accumulates a separate copy of these coefficients. The weighted matrix 
+        elements of any operator with one-body integrals F and two-body integrals II are then
+            sum_k c(k) M(k) = Vc * S + dot(F, P1.st()) + 0.5 * dot(II, P2)
+        The densities do not depend on the operators added to the object, and include any 
+        frozen core. Spin-unrestricted one-body operators are not resolved by P1.
+
+        \param xhp Field (npair x 2) of bra excitations
+        \param whp Field (npair x 2) of ket excitations
+        \param c Weight of each pair, e.g. the product of the bra and ket CI coefficients
+        \param[out] S Weighted overlap
+        \param[out] P1 Weighted one-body density matrix in AO basis
+        \param[out] P2 Weighted two-body density matrix in AO basis with the layout of the 
+                       two-electron integrals, e.g. P2(i*nbsf+j,k*nbsf+l) pairs with (ij|kl)
+     **/
+    virtual void evaluate_2rdm(
+        const arma::field<arma::umat> &xhp, const arma::field<arma::umat> &whp,
+        const arma::Col<Tc> &c, Tc &S, arma::Mat<Tc> &P1, arma::Mat<Tc> &P2) const;
+    ///@}
 
 
 private:
     virtual void spin_1rdm(
-        arma::umat &x_hp, arma::umat &w_hp, arma::Mat<Tc> &P, bool alpha);
+        const arma::umat &x_hp, const arma::umat &w_hp, arma::Mat<Tc> &P, bool alpha) const;
     virtual void spin_overlap(
-        arma::umat xhp, arma::umat whp,
-        Tc &S, bool alpha);
+        const arma::umat &xhp, const arma::umat &whp,
+        Tc &S, bool alpha) const;
     virtual void spin_one_body(
-        arma::umat xhp, arma::umat whp,
-        Tc &F, bool alpha);
+        const arma::umat &xhp, const arma::umat &whp,
+        Tc &F, bool alpha) const;
     virtual void same_spin_two_body(
-        arma::umat xhp, arma::umat whp,
-        Tc &V, bool alpha);
+        const arma::umat &xhp, const arma::umat &whp,
+        Tc &V, bool alpha) const;
     virtual void diff_spin_two_body(
-        arma::umat xa_hp, arma::umat xb_hp, 
-        arma::umat wa_hp, arma::umat wb_hp, 
-        Tc &V);
+        const arma::umat &xa_hp, const arma::umat &xb_hp, 
+        const arma::umat &wa_hp, const arma::umat &wb_hp, 
+        Tc &V) const;
 
+    /** \brief Determinants of the contractions in one spin channel for each distribution 
+               of the zero overlaps, as used in the different-spin two-body term
+     **/
+    struct spin_factors
+    {
+        size_t n = 0; //!< Number of contractions
+        size_t nperm = 0; //!< Number of zero distributions
+        const arma::uword *rows = nullptr; //!< Row indices of the contractions
+        const arma::uword *cols = nullptr; //!< Column indices of the contractions
+        const arma::uword *m = nullptr; //!< Zero distributions (n+1 per distribution)
+        const Tc *det = nullptr; //!< Determinant for each distribution
+        const Tc *adj = nullptr; //!< Adjugate for each distribution (n*n)
+        const Tc *minor = nullptr; //!< Determinant with row i and column j removed (n*n)
+    };
+
+    /** \brief Compute the determinant factors for a pair of excitations in one spin channel
+        \param xhp Bra particle-hole indices
+        \param whp Ket particle-hole indices
+        \param alpha Whether this is the alpha channel
+        \param ws Workspace holding the factors, which remain valid until the current frame is closed
+        \param[out] f Determinant factors
+     **/
+    void setup_spin_factors(
+        const arma::umat &xhp, const arma::umat &whp, bool alpha,
+        wick_workspace<Tc> &ws, spin_factors &f) const;
+
+    /** \brief Contract the alpha and beta determinant factors with the different-spin integrals
+        \param fa Alpha determinant factors
+        \param fb Beta determinant factors
+        \return Different-spin two-body contribution
+     **/
+    Tc diff_spin_contract(const spin_factors &fa, const spin_factors &fb) const;
+
+    /** \brief Weighted coefficients of the intermediates in a sum of matrix elements, which 
+               define the transition density matrices in the active orbital basis
+     **/
+    struct rdm_buffer
+    {
+        size_t da = 0; //!< Number of alpha contractions
+        size_t n2 = 0; //!< Dimension of the active orbital pairs
+        Tc S = 0.0; //!< Weighted overlap
+        arma::Col<Tc> F0a, F0b; //!< Coefficients of the F0 terms
+        arma::field<arma::Mat<Tc> > XFXa, XFXb; //!< Coefficients of the XFX terms
+        arma::Col<Tc> Vaa, Vbb; //!< Coefficients of the same-spin V0 terms
+        arma::Mat<Tc> Vab; //!< Coefficients of the different-spin V0 terms
+        arma::field<arma::Mat<Tc> > XVaXa, XVbXb, XVaXb, XVbXa; //!< Coefficients of the J/K terms
+        arma::Col<Tc> II; //!< Coefficients of the two-electron integrals
+        size_t IIoff[3] = {0, 0, 0}; //!< Offsets of the aa, bb and ab coefficients
+
+        /** \brief Coefficient of an antisymmetrised two-electron integral, with the
+                   arguments of two_body_int
+         **/
+        Tc &ii(size_t s, size_t p, size_t q, size_t r, size_t c)
+        {
+            size_t blk;
+            if(s < 2)
+            {
+                if(p > q) { std::swap(p,q); std::swap(r,c); }
+                blk = q*(q+1)/2 + p;
+            }
+            else blk = p + da*da * q;
+            return II[IIoff[s] + blk*n2*n2 + r + n2*c];
+        }
+    };
+
+    /** \brief Zeroed coefficients with the dimensions of the current pair of determinants **/
+    void rdm_init(rdm_buffer &buf) const;
+
+    /** \brief Accumulate the weighted coefficients over a list of pairs
+        \param xhp Field (npair x 2) of bra excitations
+        \param whp Field (npair x 2) of ket excitations
+        \param c Weight of each pair
+        \param[out] buf Accumulated coefficients
+     **/
+    void rdm_accumulate(
+        const arma::field<arma::umat> &xhp, const arma::field<arma::umat> &whp,
+        const arma::Col<Tc> &c, rdm_buffer &buf) const;
+
+    /** \brief One-body densities for each spin, and the matrices paired with the Coulomb 
+               and exchange matrices of each active co-density (alpha then beta)
+     **/
+    void rdm_jk(
+        const rdm_buffer &buf, arma::Mat<Tc> &Pa, arma::Mat<Tc> &Pb,
+        arma::field<arma::Mat<Tc> > &RJ, arma::field<arma::Mat<Tc> > &RK) const;
+
+    /** \brief Transform the coefficients to the AO basis
+        \param buf Accumulated coefficients
+        \param[out] P1 One-body density matrix in AO basis
+        \param[out] P2 Two-body density matrix in AO basis
+     **/
+    void rdm_transform(const rdm_buffer &buf, arma::Mat<Tc> &P1, arma::Mat<Tc> &P2) const;
+
+    /** \brief Loop over the products of coefficients with the one-body contractions in one
+               spin channel, calling f0(k, c) for F0(k) and xfx(i, j, r, s, c) for XFX(i,j)(r,s)
+     **/
+    template<typename Op0, typename Op1>
+    void spin_one_body_terms(
+        const arma::umat &xhp, const arma::umat &whp, bool alpha,
+        Op0 f0, Op1 xfx) const;
+
+    /** \brief Loop over the products of coefficients with the same-spin two-body contractions,
+               calling v0(k, c), xvx(i, k, j, r, s, c) and ii(p, q, r, s, c) for the integrals
+     **/
+    template<typename Op0, typename Op1, typename Op2>
+    void same_spin_two_body_terms(
+        const arma::umat &xhp, const arma::umat &whp, bool alpha,
+        Op0 v0, Op1 xvx, Op2 ii) const;
+
+    /** \brief Loop over the products of coefficients with the different-spin two-body 
+               contractions, calling vab(i, j, c), xvbxa(i, k, j, r, s, c), 
+               xvaxb(i, k, j, r, s, c) and ii(p, q, r, s, c) for the integrals
+     **/
+    template<typename Op0, typename Op1, typename Op2, typename Op3>
+    void diff_spin_terms(
+        const spin_factors &fa, const spin_factors &fb,
+        Op0 vab, Op1 xvbxa, Op2 xvaxb, Op3 ii) const;
+
+    /** \name Accumulate the coefficients of the contractions with weight w **/
+    ///@{
+    void spin_one_body_rdm(
+        const arma::umat &xhp, const arma::umat &whp, bool alpha, 
+        Tc w, rdm_buffer &buf) const;
+    void same_spin_two_body_rdm(
+        const arma::umat &xhp, const arma::umat &whp, bool alpha, 
+        Tc w, rdm_buffer &buf) const;
+    void diff_spin_rdm(
+        const spin_factors &fa, const spin_factors &fb, Tc w, rdm_buffer &buf) const;
+    ///@}
+
+    /** \brief Scratch memory for the matrix element evaluations on the calling thread **/
+    static wick_workspace<Tc> &workspace();
+
+    /** \brief Collect the row and column indices of the contractions for a pair of excitations
+        \param xhp Bra particle-hole indices
+        \param whp Ket particle-hole indices
+        \param[out] rows Row indices, with xhp.n_rows + whp.n_rows elements
+        \param[out] cols Column indices, with xhp.n_rows + whp.n_rows elements
+     **/
+    void ph_indices(
+        const arma::umat &xhp, const arma::umat &whp, 
+        arma::uvec &rows, arma::uvec &cols) const;
+
+    /** \brief Gather a determinant matrix into a column-major array
+        \param X Contraction matrix used on and below the diagonal
+        \param Y Contraction matrix used above the diagonal
+        \param rows Row indices
+        \param cols Column indices
+        \param[out] D Pointer to output array with at least rows.n_elem^2 elements
+     **/
+    void gather_det(
+        const arma::Mat<Tc> &X, const arma::Mat<Tc> &Y, 
+        const arma::uvec &rows, const arma::uvec &cols, Tc *D) const;
+
+    /** \brief Number of elements stored for a pair of determinants
+        \param nact Number of active orbitals
+        \param da Number of alpha contractions
+        \param db Number of beta contractions
+        \param rscf Whether the bb integrals share the aa memory
+     **/
+    size_t count_elements(size_t nact, size_t da, size_t db, bool rscf=false) const;
+
+    /** \brief Access an antisymmetrised two-electron integral
+        \param s Spin block (0 = aa, 1 = bb, 2 = ab)
+        \param p Bra contraction index
+        \param q Ket contraction index
+        \param r Row index within the block
+        \param c Column index within the block
+     **/
+    Tc two_body_int(size_t s, size_t p, size_t q, size_t r, size_t c) const
+    {
+        const size_t n2 = 4*m_nact*m_nact;
+        size_t blk;
+        if(s < 2)
+        {
+            if(p > q) { std::swap(p,q); std::swap(r,c); }
+            blk = q*(q+1)/2 + p;
+        }
+        else blk = p + ((m_nza > 0) ? 4 : 1) * q;
+        return m_IImem[m_IIoff[s] + blk*n2*n2 + r + n2*c];
+    }
+
+    /** \brief Whether the one-body term is needed, including the frozen core **/
+    bool has_one_body() const { return m_one_body or (m_ncore > 0 and m_two_body); }
+
+    virtual void setup_core();
     virtual void setup_one_body();
     virtual void setup_two_body();
 };
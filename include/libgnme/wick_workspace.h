@@ -0,0 +1,149 @@
+#ifndef LIBGNME_WICK_WORKSPACE_H
+#define LIBGNME_WICK_WORKSPACE_H
+
+#include <vector>
+#include <algorithm>
+#include <armadillo>
+#include "small_det.h"
+#include "linalg.h"
+
+namespace libgnme {
+
+/** \brief Stack of reusable scratch memory for the matrix element evaluations
+
+    Memory is handed out from blocks that are kept for the lifetime of the object,
+    and is released in last-in first-out order by the frame objects. Once the blocks
+    have grown to the largest pattern of requests, no further heap allocations occur.
+    Blocks are never moved, so pointers remain valid until their frame is closed.
+    wick keeps one workspace per thread, so no locking is required.
+
+    \tparam Tc Numerical type of the scratch values
+    \ingroup gnme_wick
+ **/
+template<typename Tc>
+class wick_workspace
+{
+private:
+    /** \brief List of memory blocks with a stack pointer **/
+    template<typename T>
+    struct arena
+    {
+        std::vector<std::vector<T> > blocks; //!< Memory blocks
+        size_t blk = 0; //!< Current block
+        size_t pos = 0; //!< Position in the current block
+
+        T *take(size_t n)
+        {
+            // Use the first block from the current position with enough space
+            for(; blk < blocks.size(); blk++, pos = 0)
+            {
+                if(pos + n > blocks[blk].size()) continue;
+                T *ptr = blocks[blk].data() + pos;
+                pos += n;
+                return ptr;
+            }
+            // Otherwise add a new block
+            blocks.push_back(std::vector<T>(std::max(n, size_t(block_size))));
+            blk = blocks.size() - 1;
+            pos = n;
+            return blocks[blk].data();
+        }
+    };
+
+    static const size_t block_size = 1024; //!< Minimum number of elements in a block
+
+    arena<Tc> m_val; //!< Numerical scratch
+    arena<arma::uword> m_idx; //!< Index scratch
+
+public:
+    /** \brief Scope of a set of scratch requests
+
+        All memory taken from the workspace while the frame is alive is returned
+        when the frame is destroyed.
+     **/
+    class frame
+    {
+    private:
+        wick_workspace &m_ws;
+        size_t m_vblk, m_vpos, m_iblk, m_ipos;
+
+    public:
+        frame(wick_workspace &ws) :
+            m_ws(ws), m_vblk(ws.m_val.blk), m_vpos(ws.m_val.pos),
+            m_iblk(ws.m_idx.blk), m_ipos(ws.m_idx.pos)
+        { }
+
+        ~frame()
+        {
+            m_ws.m_val.blk = m_vblk; m_ws.m_val.pos = m_vpos;
+            m_ws.m_idx.blk = m_iblk; m_ws.m_idx.pos = m_ipos;
+        }
+
+        frame(const frame &) = delete;
+        frame &operator=(const frame &) = delete;
+    };
+
+    /** \brief Get uninitialised scratch for n values **/
+    Tc *values(size_t n) { return m_val.take(n); }
+
+    /** \brief Get uninitialised scratch for n indices **/
+    arma::uword *indices(size_t n) { return m_idx.take(n); }
+
+    /** \brief Get a vector of indices that does not own its memory **/
+    arma::uvec index_vec(size_t n)
+    {
+        return arma::uvec(indices(n), n, false, true);
+    }
+
+    /** \brief Get an array with the first nz entries set to one and the remainder to zero,
+               for use with std::prev_permutation
+        \param n Length of the array
+        \param nz Number of non-zero entries
+     **/
+    arma::uword *permutation(size_t n, size_t nz)
+    {
+        arma::uword *m = indices(n);
+        std::fill_n(m, n, 0);
+        std::fill_n(m, std::min(nz, n), 1);
+        return m;
+    }
+};
+
+/** \brief Determinant of a column-major n x n array
+
+    Fixed-size kernels are used for n <= small_det_max.
+
+    \param n Dimension of the matrix
+    \param A Pointer to matrix elements
+    \ingroup gnme_utils
+ **/
+template<typename T>
+inline T any_det(size_t n, const T *A)
+{
+    if(n <= small_det_max) return small_det(n, A);
+    return arma::det(arma::Mat<T>(const_cast<T*>(A), n, n, false, true));
+}
+
+/** \brief Adjugate and determinant of a column-major n x n array
+
+    Fixed-size kernels are used for n <= small_det_max, with the general case
+    evaluated from the singular value decomposition using adjugate().
+
+    \param n Dimension of the matrix
+    \param A Pointer to matrix elements
+    \param[out] adj Pointer to adjugate matrix elements
+    \return Determinant of A
+    \ingroup gnme_utils
+ **/
+template<typename T>
+inline T any_adjugate(size_t n, const T *A, T *adj)
+{
+    if(n <= small_det_max) return small_adjugate(n, A, adj);
+    arma::Mat<T> M(const_cast<T*>(A), n, n, false, true);
+    arma::Mat<T> adjM(adj, n, n, false, true);
+    return adjugate(M, adjM);
+}
+
+} // namespace libgnme
+
+#endif // LIBGNME_WICK_WORKSPACE_H
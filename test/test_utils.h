@@ -0,0 +1,61 @@
+#ifndef LIBGNME_TEST_UTILS_H_
+#define LIBGNME_TEST_UTILS_H_
+
+#include <cstddef>
+#include <armadillo>
+#include <libgnme/linalg.h>
+
+/** \brief Random symmetric positive-definite overlap matrix
+    \param nbsf Number of basis functions
+ **/
+inline arma::mat random_metric(size_t nbsf)
+{
+    arma::mat S(nbsf, nbsf, arma::fill::randn);
+    S = 0.5 * (S + S.t());
+    S = S + nbsf * arma::eye(nbsf, nbsf);
+    return S;
+}
+
+/** \brief Random orbitals that are orthonormal in the metric, drawn separately for each spin
+    \param S Overlap matrix
+    \param nmo Number of orbitals in each spin
+    \param nspin Number of spin blocks of nmo columns
+ **/
+template<typename T>
+arma::Mat<T> random_orbitals(const arma::mat &S, size_t nmo, size_t nspin = 2)
+{
+    const size_t nbsf = S.n_rows;
+    arma::Mat<T> C(nbsf, nspin*nmo);
+    for(size_t s=0; s < nspin; s++)
+    {
+        arma::Mat<T> Cs(nbsf, nmo, arma::fill::randn);
+        arma::Mat<T> Ss = Cs.t() * S * Cs, X;
+        libgnme::orthogonalisation_matrix(nmo, Ss, 1e-10, X);
+        C.cols(s*nmo, s*nmo+nmo-1) = Cs * X;
+    }
+    return C;
+}
+
+/** \brief Two-electron integrals (ij|kl) = sum_P L(i,j,P) L(k,l,P) from symmetric factors
+    \param L Three-index factors with symmetric slices
+ **/
+inline arma::mat factorised_eri(const arma::cube &L)
+{
+    arma::mat Lm(L.memptr(), L.n_rows*L.n_cols, L.n_slices);
+    return Lm * Lm.t();
+}
+
+/** \brief Two-electron integrals from random symmetric three-index factors
+    \param nbsf Number of basis functions
+    \param naux Number of factors
+    \param[out] L Three-index factors
+ **/
+inline arma::mat factorised_eri(size_t nbsf, size_t naux, arma::cube &L)
+{
+    L.randn(nbsf, nbsf, naux);
+    for(size_t P=0; P < naux; P++)
+        L.slice(P) = 0.5 * (L.slice(P) + L.slice(P).t());
+    return factorised_eri(L);
+}
+
+#endif // LIBGNME_TEST_UTILS_H_